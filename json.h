@@ -8,6 +8,40 @@
 #include <initializer_list>
 #include <type_traits>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <cstdlib>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+// 多字节UTF-8校验需要SSSE3的pshufb。编译时没有打开SSSE3时，
+// 用target属性单独编译校验函数，运行时再检查CPU是否支持
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <tmmintrin.h>
+#define JSON_UTF8_SIMD
+#if defined(__SSSE3__)
+#define JSON_TARGET_SSSE3
+#else
+#define JSON_TARGET_SSSE3 __attribute__((target("ssse3")))
+#endif
+#endif
+#if __cplusplus >= 202002L
+#include <string_view>
+#include <bit>
+#endif
+
+// C++20起允许在编译期调用的辅助函数
+#if __cplusplus >= 202002L
+#define JSON_CONSTEXPR constexpr
+#else
+#define JSON_CONSTEXPR
+#endif
 
 using std::enable_if;
 using std::initializer_list;
@@ -21,12 +55,262 @@ using std::vector;
 
 namespace myJson
 {
-    string json_escape(const string &str)
+    // 扫描一段无需特殊处理的普通字节，返回第一个需要处理的字节位置。
+    // 需要处理的字节为'"'、'\\'、控制字符(<0x20)，stopNonAscii时还包括非ASCII字节。
+    // 支持SSE2时每次检查16个字节。
+    size_t scanPlain(const char *s, size_t i, size_t len, bool stopNonAscii)
+    {
+#if defined(__SSE2__)
+        const __m128i quote = _mm_set1_epi8('\"');
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i ctrl = _mm_set1_epi8(0x1F);
+        for (; i + 16 <= len; i += 16)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+            // max(c, 0x1F) == 0x1F 当且仅当 c <= 0x1F（无符号比较）
+            __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                           _mm_cmpeq_epi8(chunk, backslash));
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(_mm_max_epu8(chunk, ctrl), ctrl));
+            int mask = _mm_movemask_epi8(special);
+            if (stopNonAscii)
+                mask |= _mm_movemask_epi8(chunk);
+            if (mask != 0)
+                return i + __builtin_ctz(mask);
+        }
+#endif
+        for (; i < len; ++i)
+        {
+            unsigned char c = static_cast<unsigned char>(s[i]);
+            if (c == '\"' || c == '\\' || c < 0x20 || (stopNonAscii && c >= 0x80))
+                return i;
+        }
+        return len;
+    }
+
+    // 从s处解码一个UTF-8字符到cp，返回占用的字节数，非法编码返回0。
+    // 拒绝过长编码、代理区(U+D800~U+DFFF)以及超过U+10FFFF的码点。
+    JSON_CONSTEXPR size_t utf8Decode(const char *str, size_t len, unsigned &cp)
+    {
+        unsigned char s[4] = {static_cast<unsigned char>(str[0]), 0, 0, 0};
+        if (s[0] < 0x80)
+        {
+            cp = s[0];
+            return 1;
+        }
+        size_t n = 0;
+        unsigned char lo = 0x80, hi = 0xBF;
+        if (s[0] >= 0xC2 && s[0] <= 0xDF)
+        {
+            n = 2;
+            cp = s[0] & 0x1F;
+        }
+        else if (s[0] >= 0xE0 && s[0] <= 0xEF)
+        {
+            n = 3;
+            cp = s[0] & 0x0F;
+            if (s[0] == 0xE0)
+                lo = 0xA0;
+            else if (s[0] == 0xED)
+                hi = 0x9F;
+        }
+        else if (s[0] >= 0xF0 && s[0] <= 0xF4)
+        {
+            n = 4;
+            cp = s[0] & 0x07;
+            if (s[0] == 0xF0)
+                lo = 0x90;
+            else if (s[0] == 0xF4)
+                hi = 0x8F;
+        }
+        else
+            return 0;
+        if (len < n)
+            return 0;
+        for (size_t i = 1; i < n; ++i)
+            s[i] = static_cast<unsigned char>(str[i]);
+        if (s[1] < lo || s[1] > hi)
+            return 0;
+        cp = (cp << 6) | (s[1] & 0x3F);
+        for (size_t i = 2; i < n; ++i)
+        {
+            if ((s[i] & 0xC0) != 0x80)
+                return 0;
+            cp = (cp << 6) | (s[i] & 0x3F);
+        }
+        return n;
+    }
+
+#if defined(JSON_UTF8_SIMD)
+    // 校验16个字节，prev是上一组字节，prevIncomplete标记上一组末尾未完成的多字节字符。
+    // 查表法（Keiser & Lemire, "Validating UTF-8 In Less Than One Instruction Per Byte"）：
+    // 用前一个字节的高低4位和当前字节的高4位查三张表，三者按位与得到各类错误，
+    // 再单独检查三、四字节字符需要的第2、3个后续字节。
+    JSON_TARGET_SSSE3 void utf8CheckBlock(__m128i input, __m128i &prev, __m128i &prevIncomplete, __m128i &error)
+    {
+        if (_mm_movemask_epi8(input) == 0)
+        {
+            // 纯ASCII：只需要确认上一组没有未完成的字符
+            error = _mm_or_si128(error, prevIncomplete);
+            prev = input;
+            prevIncomplete = _mm_setzero_si128();
+            return;
+        }
+        const char tooShort = 1 << 0, tooLong = 1 << 1, overlong3 = 1 << 2, tooLarge = 1 << 3,
+                   surrogate = 1 << 4, overlong2 = 1 << 5, tooLarge1000 = 1 << 6, overlong4 = 1 << 6,
+                   twoConts = static_cast<char>(1 << 7);
+        const char carry = tooShort | tooLong | twoConts;
+        // 前一个字节的高4位
+        const __m128i byte1High = _mm_setr_epi8(
+            tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong, tooLong,
+            twoConts, twoConts, twoConts, twoConts,
+            tooShort | overlong2, tooShort, tooShort | overlong3 | surrogate,
+            tooShort | tooLarge | tooLarge1000 | overlong4);
+        // 前一个字节的低4位
+        const __m128i byte1Low = _mm_setr_epi8(
+            carry | overlong3 | overlong2 | overlong4, carry | overlong2, carry, carry,
+            carry | tooLarge, carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,
+            carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,
+            carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000, carry | tooLarge | tooLarge1000,
+            carry | tooLarge | tooLarge1000 | surrogate, carry | tooLarge | tooLarge1000,
+            carry | tooLarge | tooLarge1000);
+        // 当前字节的高4位
+        const __m128i byte2High = _mm_setr_epi8(
+            tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort, tooShort,
+            tooLong | overlong2 | twoConts | overlong3 | tooLarge1000 | overlong4,
+            tooLong | overlong2 | twoConts | overlong3 | tooLarge,
+            tooLong | overlong2 | twoConts | surrogate | tooLarge,
+            tooLong | overlong2 | twoConts | surrogate | tooLarge,
+            tooShort, tooShort, tooShort, tooShort);
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        __m128i prev1 = _mm_alignr_epi8(input, prev, 15);
+        __m128i special = _mm_and_si128(
+            _mm_and_si128(_mm_shuffle_epi8(byte1High, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                          _mm_shuffle_epi8(byte1Low, _mm_and_si128(prev1, nibble))),
+            _mm_shuffle_epi8(byte2High, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+        // 两个字节之前是三/四字节的首字节，或者三个字节之前是四字节的首字节时，当前字节必须是后续字节
+        __m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 14), _mm_set1_epi8(0xE0 - 0x80));
+        __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev, 13), _mm_set1_epi8(0xF0 - 0x80));
+        __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)));
+        error = _mm_or_si128(error, _mm_xor_si128(must23, special));
+        // 最后三个字节中出现的首字节需要下一组补全
+        const __m128i maxComplete = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                  static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1),
+                                                  static_cast<char>(0xC0 - 1));
+        prevIncomplete = _mm_subs_epu8(input, maxComplete);
+        prev = input;
+    }
+
+    // SIMD的UTF-8校验，每次处理16个字节，末尾不足16字节时补0
+    JSON_TARGET_SSSE3 bool utf8ValidateSimd(const char *s, size_t len)
+    {
+        __m128i prev = _mm_setzero_si128(), prevIncomplete = _mm_setzero_si128(), error = _mm_setzero_si128();
+        size_t i = 0;
+        for (; i + 16 <= len; i += 16)
+            utf8CheckBlock(_mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i)), prev, prevIncomplete, error);
+        if (i < len)
+        {
+            char tail[16] = {};
+            std::memcpy(tail, s + i, len - i);
+            utf8CheckBlock(_mm_loadu_si128(reinterpret_cast<const __m128i *>(tail)), prev, prevIncomplete, error);
+        }
+        error = _mm_or_si128(error, prevIncomplete);
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(error, _mm_setzero_si128())) == 0xFFFF;
+    }
+#endif
+
+    // 校验UTF-8编码是否合法。
+    // 不少于16字节时使用SIMD查表校验（需要SSSE3，ASCII和多字节字符都按16字节一组处理），
+    // 否则逐字符解码。
+    bool utf8Validate(const char *s, size_t len)
+    {
+#if defined(JSON_UTF8_SIMD)
+#if defined(__SSSE3__)
+        const bool simd = true;
+#else
+        static const bool simd = __builtin_cpu_supports("ssse3");
+#endif
+        if (simd && len >= 16)
+            return utf8ValidateSimd(s, len);
+#endif
+        size_t i = 0;
+        while (i < len)
+        {
+            if (static_cast<unsigned char>(s[i]) < 0x80)
+            {
+                ++i;
+                continue;
+            }
+            unsigned cp;
+            size_t n = utf8Decode(s + i, len - i, cp);
+            if (n == 0)
+                return false;
+            i += n;
+        }
+        return true;
+    }
+
+    // 把码点编码成UTF-8写入out，返回写入的字节数
+    JSON_CONSTEXPR size_t utf8EncodeTo(unsigned cp, char *out)
+    {
+        if (cp < 0x80)
+        {
+            out[0] = static_cast<char>(cp);
+            return 1;
+        }
+        if (cp < 0x800)
+        {
+            out[0] = static_cast<char>(0xC0 | (cp >> 6));
+            out[1] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 2;
+        }
+        if (cp < 0x10000)
+        {
+            out[0] = static_cast<char>(0xE0 | (cp >> 12));
+            out[1] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (cp & 0x3F));
+            return 3;
+        }
+        out[0] = static_cast<char>(0xF0 | (cp >> 18));
+        out[1] = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (cp & 0x3F));
+        return 4;
+    }
+
+    // 把码点编码成UTF-8追加到output
+    void utf8Encode(unsigned cp, string &output)
+    {
+        char buf[4] = {};
+        output.append(buf, utf8EncodeTo(cp, buf));
+    }
+
+    // 以\uXXXX的形式追加一个UTF-16码元
+    void appendUnicodeEscape(unsigned unit, string &output)
+    {
+        static const char hex[] = "0123456789abcdef";
+        char buf[6] = {'\\', 'u', hex[(unit >> 12) & 0xF], hex[(unit >> 8) & 0xF],
+                       hex[(unit >> 4) & 0xF], hex[unit & 0xF]};
+        output.append(buf, 6);
+    }
+
+    // 转义字符串，普通字节成段拷贝。
+    // asciiOnly为true时，非ASCII字符输出为\uXXXX（必要时使用代理对），
+    // 非法的UTF-8字节输出为\ufffd。
+    string json_escape(const string &str, bool asciiOnly = false)
     {
         string output;
-        for (unsigned i = 0; i < str.length(); ++i)
+        output.reserve(str.length() + 2);
+        const char *s = str.data();
+        size_t len = str.length();
+        size_t i = 0;
+        while (i < len)
         {
-            switch (str[i])
+            size_t run = scanPlain(s, i, len, asciiOnly);
+            output.append(s + i, run - i);
+            if (run >= len)
+                break;
+            i = run + 1;
+            switch (s[run])
             {
             case '\"':
                 output += "\\\"";
@@ -50,13 +334,119 @@ namespace myJson
                 output += "\\t";
                 break;
             default:
-                output += str[i];
-                break;
+            {
+                unsigned char c = static_cast<unsigned char>(s[run]);
+                if (c < 0x20)
+                {
+                    appendUnicodeEscape(c, output);
+                    break;
+                }
+                // 只有asciiOnly时才会停在非ASCII字节上
+                unsigned cp;
+                size_t n = utf8Decode(s + run, len - run, cp);
+                if (n == 0)
+                {
+                    appendUnicodeEscape(0xFFFD, output);
+                    break;
+                }
+                i = run + n;
+                if (cp >= 0x10000)
+                {
+                    cp -= 0x10000;
+                    appendUnicodeEscape(0xD800 | (cp >> 10), output);
+                    appendUnicodeEscape(0xDC00 | (cp & 0x3FF), output);
+                }
+                else
+                    appendUnicodeEscape(cp, output);
+            }
+            break;
             }
         }
         return std::move(output);
     }
 
+    // 64位混合函数（MurmurHash3的fmix64）
+    uint64_t hashMix(uint64_t h)
+    {
+        h ^= h >> 33;
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 33;
+        h *= 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    // 64位字节串哈希，每次处理8个字节。
+    // 按小端序组装字节，结果与运行次数和平台无关。
+    uint64_t hashBytes(const char *s, size_t len, uint64_t seed)
+    {
+        const uint64_t k = 0x9E3779B97F4A7C15ULL;
+        uint64_t h = seed ^ (len * k);
+        size_t i = 0;
+        for (; i + 8 <= len; i += 8)
+        {
+            uint64_t w = 0;
+            for (int b = 7; b >= 0; --b)
+                w = (w << 8) | static_cast<unsigned char>(s[i + b]);
+            h = (h ^ hashMix(w)) * k;
+        }
+        if (i < len)
+        {
+            uint64_t w = 0;
+            for (size_t b = len; b > i; --b)
+                w = (w << 8) | static_cast<unsigned char>(s[b - 1]);
+            h = (h ^ hashMix(w)) * k;
+        }
+        return hashMix(h);
+    }
+
+    // 按RFC 8785（即ECMAScript的Number.toString）格式输出浮点数：
+    // 使用能精确还原的最短有效数字，NaN和无穷大输出为null
+    string canonicalNumber(double d)
+    {
+        if (std::isnan(d) || std::isinf(d))
+            return "null";
+        if (d == 0)
+            return "0";
+        char buf[32];
+        double back = 0;
+        int precision = 1;
+        for (; precision < 17; ++precision)
+        {
+            snprintf(buf, sizeof(buf), "%.*e", precision - 1, d);
+            back = std::strtod(buf, nullptr);
+            if (back == d)
+                break;
+        }
+        snprintf(buf, sizeof(buf), "%.*e", precision - 1, d);
+        // buf形如"-d.ddde+XX"，拆成有效数字和指数
+        string digits;
+        const char *p = buf;
+        string out = (*p == '-') ? "-" : "";
+        if (*p == '-')
+            ++p;
+        for (; *p != 'e'; ++p)
+            if (*p != '.')
+                digits += *p;
+        int n = std::atoi(p + 1) + 1;
+        int k = static_cast<int>(digits.size());
+        if (k <= n && n <= 21)
+            out += digits + string(n - k, '0');
+        else if (0 < n && n <= 21)
+            out += digits.substr(0, n) + "." + digits.substr(n);
+        else if (-6 < n && n <= 0)
+            out += "0." + string(-n, '0') + digits;
+        else
+        {
+            out += digits.substr(0, 1);
+            if (k > 1)
+                out += "." + digits.substr(1);
+            out += (n - 1 < 0) ? "e-" : "e+";
+            out += std::to_string(std::abs(n - 1));
+        }
+        return out;
+    }
+
     class json
     {
     private:
@@ -93,7 +483,7 @@ namespace myJson
         {
             SetType(Class::Object);
             for (auto i = list.begin(), e = list.end(); i != e; i++, i++)
-                operator[](i->toString()) = *std::next(i);
+                operator[](i->Type == Class::String ? *i->Data.String : string("")) = *std::next(i);
         }
         // 左值复制构造函数
         json(const json &other)
@@ -115,7 +505,8 @@ namespace myJson
             Type = other.Type;
         }
         // 右值复制构造函数
-        json(json &&other) : Data(other.Data), Type(other.Type)
+        // 声明为noexcept，vector扩容时移动元素而不是深拷贝
+        json(json &&other) noexcept : Data(other.Data), Type(other.Type)
         {
             other.Type = Class::Null;
             other.Data.Map = nullptr;
@@ -221,6 +612,52 @@ namespace myJson
                 return Data.Array->size();
             }
         }
+        // 查找子节点，不存在时返回nullptr，不会像operator[]那样创建新节点
+        json *find(const string &key)
+        {
+            if (Type != Class::Object)
+                return nullptr;
+            auto it = Data.Map->find(key);
+            return it == Data.Map->end() ? nullptr : &it->second;
+        }
+        json *find(unsigned index)
+        {
+            return (Type == Class::Array && index < Data.Array->size()) ? &(*Data.Array)[index] : nullptr;
+        }
+        const json *find(const string &key) const { return const_cast<json *>(this)->find(key); }
+        const json *find(unsigned index) const { return const_cast<json *>(this)->find(index); }
+        // 在数组的index处插入元素
+        void insert(unsigned index, json value)
+        {
+            SetType(Class::Array);
+            if (index > Data.Array->size())
+                index = Data.Array->size();
+            Data.Array->insert(Data.Array->begin() + index, std::move(value));
+        }
+        // 删除对象的key，返回是否存在
+        bool erase(const string &key)
+        {
+            return Type == Class::Object && Data.Map->erase(key) > 0;
+        }
+        // 删除数组的第index个元素，返回是否存在
+        bool erase(unsigned index)
+        {
+            if (Type != Class::Array || index >= Data.Array->size())
+                return false;
+            Data.Array->erase(Data.Array->begin() + index);
+            return true;
+        }
+        // 遍历对象/数组，类型不符时返回空容器
+        const map<string, json> &objectItems() const
+        {
+            static const map<string, json> empty;
+            return Type == Class::Object ? *Data.Map : empty;
+        }
+        const vector<json> &arrayItems() const
+        {
+            static const vector<json> empty;
+            return Type == Class::Array ? *Data.Array : empty;
+        }
         // 获取类型信息
         Class jsonType() const { return Type; }
         // 判空
@@ -231,6 +668,12 @@ namespace myJson
         {
             return (Type == Class::String) ? std::move(json_escape(*Data.String)) : string("");
         }
+        // 未转义的字符串内容，非字符串类型返回空串
+        const string &stringValue() const
+        {
+            static const string empty;
+            return (Type == Class::String) ? *Data.String : empty;
+        }
         // 转成浮点数
         double toFloat() const
         {
@@ -248,8 +691,8 @@ namespace myJson
         }
 
         // 生成可打印的字符串格式
-        // depth是递归深度，tab是缩进大小，然后
-        string dump(int depth = 1, string tab = "  ") const
+        // depth是递归深度，tab是缩进大小，asciiOnly为true时非ASCII字符输出为\uXXXX
+        string dump(int depth = 1, string tab = "  ", bool asciiOnly = false) const
         {
             string pad = "";
             for (int i = 0; i < depth; ++i, pad += tab)
@@ -266,7 +709,7 @@ namespace myJson
                 {
                     if (!skip)
                         s += ",\n";
-                    s += (pad + "\"" + p.first + "\" : " + p.second.dump(depth + 1, tab));
+                    s += (pad + "\"" + json_escape(p.first, asciiOnly) + "\" : " + p.second.dump(depth + 1, tab, asciiOnly));
                     skip = false;
                 }
                 s += ("\n" + pad.erase(0, 2) + "}");
@@ -280,14 +723,14 @@ namespace myJson
                 {
                     if (!skip)
                         s += ",";
-                    s += p.dump(depth + 1, tab);
+                    s += p.dump(depth + 1, tab, asciiOnly);
                     skip = false;
                 }
                 s += "]";
                 return s;
             }
             case Class::String:
-                return "\"" + json_escape(*Data.String) + "\"";
+                return "\"" + json_escape(*Data.String, asciiOnly) + "\"";
             case Class::Floating:
                 return std::to_string(Data.Float);
             case Class::Integral:
@@ -299,6 +742,19 @@ namespace myJson
             }
             return "";
         }
+        // 规范化的紧凑输出（RFC 8785风格）：键按字典序排列，无空白，数字使用最短表示。
+        // 键按UTF-8字节序排序，仅在同时出现增补平面字符和U+E000~U+FFFF时与UTF-16序不同。
+        string canonical() const
+        {
+            string out;
+            canonicalTo(out);
+            return out;
+        }
+        // 深度比较，整数和值相同的浮点数视为相等
+        bool operator==(const json &other) const;
+        bool operator!=(const json &other) const { return !(*this == other); }
+        // 结构化哈希，与运行次数无关，相等的对象哈希值相同
+        uint64_t hash() const;
         // 按照字符串格式输出json对象
         friend std::ostream &operator<<(std::ostream &os, const json &jsonObject)
         {
@@ -307,6 +763,12 @@ namespace myJson
         }
 
     private:
+        void canonicalTo(string &out) const;
+        // 浮点数是否可以无损地表示为整数
+        static bool integralFloat(double d)
+        {
+            return std::floor(d) == d && d >= -9223372036854775808.0 && d < 9223372036854775808.0;
+        }
         // 根据类型重新创建对象（分配空间）
         void SetType(Class type)
         {
@@ -409,6 +871,152 @@ namespace myJson
         return *this;
     }
 
+    // 深度比较
+    bool json::operator==(const json &other) const
+    {
+        if (this == &other)
+            return true;
+        if (Type != other.Type)
+        {
+            // 整数和浮点数按数值比较
+            if (Type == Class::Integral && other.Type == Class::Floating)
+                return integralFloat(other.Data.Float) && static_cast<long>(other.Data.Float) == Data.Int;
+            if (Type == Class::Floating && other.Type == Class::Integral)
+                return other == *this;
+            return false;
+        }
+        switch (Type)
+        {
+        case Class::Null:
+            return true;
+        case Class::Object:
+        {
+            if (Data.Map->size() != other.Data.Map->size())
+                return false;
+            // map是有序的，可以逐对比较
+            for (auto i = Data.Map->begin(), j = other.Data.Map->begin(); i != Data.Map->end(); ++i, ++j)
+                if (i->first != j->first || i->second != j->second)
+                    return false;
+            return true;
+        }
+        case Class::Array:
+        {
+            if (Data.Array->size() != other.Data.Array->size())
+                return false;
+            for (size_t i = 0; i < Data.Array->size(); ++i)
+                if ((*Data.Array)[i] != (*other.Data.Array)[i])
+                    return false;
+            return true;
+        }
+        case Class::String:
+            return *Data.String == *other.Data.String;
+        case Class::Floating:
+            return Data.Float == other.Data.Float;
+        case Class::Integral:
+            return Data.Int == other.Data.Int;
+        case Class::Boolean:
+            return Data.Bool == other.Data.Bool;
+        }
+        return false;
+    }
+
+    // 结构化哈希。
+    // 对象的各个键值对哈希后求和，结果与键的顺序无关；数组按顺序组合。
+    uint64_t json::hash() const
+    {
+        const uint64_t k = 0x9E3779B97F4A7C15ULL;
+        switch (Type)
+        {
+        case Class::Object:
+        {
+            uint64_t sum = 0;
+            for (auto &p : *Data.Map)
+                sum += hashMix(hashBytes(p.first.data(), p.first.size(), 1) ^ (p.second.hash() * k));
+            return hashMix(sum ^ (Data.Map->size() * k) ^ 2);
+        }
+        case Class::Array:
+        {
+            uint64_t h = 3 ^ (Data.Array->size() * k);
+            for (auto &e : *Data.Array)
+                h = hashMix(h + e.hash() * k);
+            return h;
+        }
+        case Class::String:
+            return hashBytes(Data.String->data(), Data.String->size(), 4);
+        case Class::Floating:
+            if (!integralFloat(Data.Float))
+            {
+                uint64_t bits;
+                double d = std::isnan(Data.Float) ? NAN : Data.Float;
+                std::memcpy(&bits, &d, sizeof(bits));
+                return hashMix(bits ^ 5);
+            }
+            // 值为整数的浮点数与对应的整数哈希值相同
+            return hashMix(static_cast<uint64_t>(static_cast<long>(Data.Float)) ^ 6);
+        case Class::Integral:
+            return hashMix(static_cast<uint64_t>(Data.Int) ^ 6);
+        case Class::Boolean:
+            return Data.Bool ? 7 : 8;
+        default:
+            return 0;
+        }
+    }
+
+    // 规范化输出
+    void json::canonicalTo(string &out) const
+    {
+        switch (Type)
+        {
+        case Class::Object:
+        {
+            out += '{';
+            bool skip = true;
+            for (auto &p : *Data.Map)
+            {
+                if (!skip)
+                    out += ',';
+                out += '\"';
+                out += json_escape(p.first);
+                out += "\":";
+                p.second.canonicalTo(out);
+                skip = false;
+            }
+            out += '}';
+        }
+        break;
+        case Class::Array:
+        {
+            out += '[';
+            bool skip = true;
+            for (auto &e : *Data.Array)
+            {
+                if (!skip)
+                    out += ',';
+                e.canonicalTo(out);
+                skip = false;
+            }
+            out += ']';
+        }
+        break;
+        case Class::String:
+            out += '\"';
+            out += json_escape(*Data.String);
+            out += '\"';
+            break;
+        case Class::Floating:
+            out += canonicalNumber(Data.Float);
+            break;
+        case Class::Integral:
+            out += std::to_string(Data.Int);
+            break;
+        case Class::Boolean:
+            out += Data.Bool ? "true" : "false";
+            break;
+        default:
+            out += "null";
+        }
+    }
+
     // 获得不同类型的实例
     // 获取一个数组
     json Array()
@@ -430,8 +1038,9 @@ namespace myJson
     // 这个名称空间里面是解析使用的函数
     namespace
     {
-        // 先声明parseNext
+        // 先声明parseNext和parseStringRaw
         json parseNext(const string &str, size_t &offset);
+        bool parseStringRaw(const string &str, size_t &offset, string &val);
 
         // 跳过前面的空白符
         void consumeWs(const string &str, size_t &offset)
@@ -457,7 +1066,13 @@ namespace myJson
             }
             while (true)
             {
-                json key = parseNext(str, offset);
+                string key;
+                consumeWs(str, offset);
+                if (str[offset] != '\"' || !parseStringRaw(str, offset, key))
+                {
+                    std::cout << "Error: Pharse object failed!" << std::endl;
+                    break;
+                }
                 consumeWs(str, offset);
                 if (str[offset] != ':')
                 {
@@ -466,7 +1081,7 @@ namespace myJson
                 }
                 consumeWs(str, ++offset);
                 json value = parseNext(str, offset);
-                res[key.toString()] = value;
+                res[key] = value;
                 consumeWs(str, offset);
                 if (str[offset] == ',')
                 {
@@ -520,69 +1135,120 @@ namespace myJson
             }
             return std::move(res);
         }
-        // 解析字符串
-        json parseString(const string &str, size_t &offset)
+        // 读取\u后面的4位十六进制数，失败返回false
+        bool parseHex4(const string &str, size_t offset, unsigned &unit)
         {
-            json res;
-            string val;
-            for (char c = str[++offset]; c != '\"'; c = str[++offset])
+            unit = 0;
+            for (unsigned i = 0; i < 4; ++i)
+            {
+                char c = str[offset + i];
+                unit <<= 4;
+                if (c >= '0' && c <= '9')
+                    unit |= c - '0';
+                else if (c >= 'a' && c <= 'f')
+                    unit |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F')
+                    unit |= c - 'A' + 10;
+                else
+                    return false;
+            }
+            return true;
+        }
+        // 解析字符串内容到val，offset指向开头的'"'，结束后指向结尾'"'的下一位。
+        // 普通字节成段校验UTF-8后整体拷贝，\u转义（含代理对）解码为UTF-8。
+        // val为nullptr时只做校验，不拷贝内容。
+        bool readString(const string &str, size_t &offset, string *val)
+        {
+            const char *s = str.data();
+            size_t len = str.size();
+            ++offset;
+            while (true)
             {
+                size_t run = scanPlain(s, offset, len, false);
+                if (run > offset)
+                {
+                    if (!utf8Validate(s + offset, run - offset))
+                        return false;
+                    if (val)
+                        val->append(s + offset, run - offset);
+                    offset = run;
+                }
+                // 未闭合的字符串或者未转义的控制字符
+                if (offset >= len || static_cast<unsigned char>(s[offset]) < 0x20)
+                    return false;
+                if (s[offset] == '\"')
+                    break;
                 // 额外转义过的字符
-                if (c == '\\')
+                char c = 0;
+                switch (str[++offset])
                 {
-                    switch (str[++offset])
-                    {
-                    case '\"':
-                        val += '\"';
-                        break;
-                    case '\\':
-                        val += '\\';
-                        break;
-                    case '/':
-                        val += '/';
-                        break;
-                    case 'b':
-                        val += '\b';
-                        break;
-                    case 'f':
-                        val += '\f';
-                        break;
-                    case 'n':
-                        val += '\n';
-                        break;
-                    case 'r':
-                        val += '\r';
-                    case 't':
-                        val += '\t';
-                        break;
-                    case 'u':
-                    {
-                        val += "\\u";
-                        for (unsigned i = 1; i <= 4; ++i)
-                        {
-                            c = str[offset + i];
-                            if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F'))
-                                val += c;
-                            else
-                            {
-                                std::cout << "Error: Parse string failed!" << std::endl;
-                                return std::move(json::Make(json::Class::String));
-                            }
-                        }
-                        offset += 4;
-                    }
+                case '\"':
+                case '\\':
+                case '/':
+                    c = str[offset];
                     break;
-                    default:
-                        val += '\\';
-                        break;
+                case 'b':
+                    c = '\b';
+                    break;
+                case 'f':
+                    c = '\f';
+                    break;
+                case 'n':
+                    c = '\n';
+                    break;
+                case 'r':
+                    c = '\r';
+                    break;
+                case 't':
+                    c = '\t';
+                    break;
+                case 'u':
+                {
+                    unsigned cp;
+                    if (!parseHex4(str, offset + 1, cp))
+                        return false;
+                    offset += 4;
+                    if (cp >= 0xDC00 && cp <= 0xDFFF)
+                        return false;
+                    if (cp >= 0xD800 && cp <= 0xDBFF)
+                    {
+                        // 高代理后面必须紧跟低代理
+                        unsigned low;
+                        if (str[offset + 1] != '\\' || str[offset + 2] != 'u' ||
+                            !parseHex4(str, offset + 3, low) || low < 0xDC00 || low > 0xDFFF)
+                            return false;
+                        offset += 6;
+                        cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
                     }
+                    if (val)
+                        utf8Encode(cp, *val);
+                    ++offset;
+                    continue;
                 }
-                else
-                    val += c;
+                default:
+                    return false;
+                }
+                if (val)
+                    *val += c;
+                ++offset;
             }
             ++offset;
-            res = val;
-            return std::move(res);
+            return true;
+        }
+        bool parseStringRaw(const string &str, size_t &offset, string &val)
+        {
+            return readString(str, offset, &val);
+        }
+        // 解析字符串
+        json parseString(const string &str, size_t &offset)
+        {
+            string val;
+            if (!parseStringRaw(str, offset, val))
+            {
+                std::cout << "Error: Parse string failed!" << std::endl;
+                return std::move(json::Make(json::Class::String));
+            }
+            return std::move(json(val));
         }
         // 解析数字（浮点数或者整型数）
         json parseNumber(const string &str, size_t &offset)
@@ -691,5 +1357,1645 @@ namespace myJson
         size_t offset = 0;
         return std::move(parseNext(str, offset));
     }
+
+    // 按预先声明的文档结构解析json对象。
+    // 字段按声明顺序优先匹配，顺序不一致时退回按名字查找，未声明的字段直接跳过；
+    // 字段的值直接按声明的类型解析，不经过parseNext的分派。
+    class schema
+    {
+    public:
+        // 声明一个字段，required为false时字段可以缺失或者为null
+        schema &field(const string &key, json::Class type, bool required = true);
+        // 声明一个嵌套对象字段
+        schema &field(const string &key, const schema &nested, bool required = true);
+        // 字段在记录中的位置，未声明返回-1
+        int index(const string &key) const;
+        // 已声明的字段数
+        size_t size() const { return fields.size(); }
+        // 解析成平坦记录，record[i]对应第i个声明的字段，缺失的可选字段为null
+        bool parse(const string &str, vector<json> &record, string *error = nullptr) const;
+        // 解析成json对象，缺失的可选字段不出现在结果中
+        bool parse(const string &str, json &out, string *error = nullptr) const;
+
+    private:
+        struct Field
+        {
+            string key;
+            json::Class type;
+            bool required;
+            std::shared_ptr<schema> nested;
+        };
+        vector<Field> fields;
+        map<string, size_t> lookup;
+
+        schema &addField(const Field &f);
+        json toObject(vector<json> &record) const;
+        bool parseObject(const string &str, size_t &offset, vector<json> &record, string &error) const;
+        bool parseValue(const Field &f, const string &str, size_t &offset, json &value, string &error) const;
+        static size_t scanNumber(const string &str, size_t offset, bool &isDouble);
+        static bool skipValue(const string &str, size_t &offset);
+        static bool parseAny(const string &str, size_t &offset, json &value);
+    };
+
+    schema &schema::addField(const Field &f)
+    {
+        lookup[f.key] = fields.size();
+        fields.push_back(f);
+        return *this;
+    }
+    schema &schema::field(const string &key, json::Class type, bool required)
+    {
+        return addField(Field{key, type, required, nullptr});
+    }
+    schema &schema::field(const string &key, const schema &nested, bool required)
+    {
+        return addField(Field{key, json::Class::Object, required, std::make_shared<schema>(nested)});
+    }
+    int schema::index(const string &key) const
+    {
+        auto it = lookup.find(key);
+        return it == lookup.end() ? -1 : static_cast<int>(it->second);
+    }
+
+    bool schema::parse(const string &str, vector<json> &record, string *error) const
+    {
+        string message;
+        size_t offset = 0;
+        record.assign(fields.size(), json());
+        consumeWs(str, offset);
+        bool ok = parseObject(str, offset, record, message);
+        if (ok)
+        {
+            consumeWs(str, offset);
+            if (offset != str.size())
+            {
+                message = "trailing characters after document";
+                ok = false;
+            }
+        }
+        // 成功时清空之前的错误信息
+        if (error)
+            *error = message;
+        return ok;
+    }
+    bool schema::parse(const string &str, json &out, string *error) const
+    {
+        vector<json> record;
+        if (!parse(str, record, error))
+            return false;
+        out = toObject(record);
+        return true;
+    }
+
+    // 把记录转换成json对象，缺失的可选字段跳过
+    json schema::toObject(vector<json> &record) const
+    {
+        json res = json::Make(json::Class::Object);
+        for (size_t i = 0; i < fields.size(); ++i)
+            if (!record[i].isNull() || fields[i].type == json::Class::Null)
+                res[fields[i].key] = std::move(record[i]);
+        return res;
+    }
+
+    // 解析对象，按声明顺序猜测下一个字段
+    bool schema::parseObject(const string &str, size_t &offset, vector<json> &record, string &error) const
+    {
+        if (str[offset] != '{')
+        {
+            error = "expected object";
+            return false;
+        }
+        vector<bool> seen(fields.size(), false);
+        size_t expected = 0;
+        string key;
+        consumeWs(str, ++offset);
+        if (str[offset] == '}')
+            ++offset;
+        else
+            while (true)
+            {
+                consumeWs(str, offset);
+                key.clear();
+                if (str[offset] != '\"' || !parseStringRaw(str, offset, key))
+                {
+                    error = "invalid object key";
+                    return false;
+                }
+                consumeWs(str, offset);
+                if (str[offset] != ':')
+                {
+                    error = "expected ':' after key '" + key + "'";
+                    return false;
+                }
+                consumeWs(str, ++offset);
+                size_t slot = fields.size();
+                if (expected < fields.size() && fields[expected].key == key)
+                    slot = expected;
+                else
+                {
+                    auto it = lookup.find(key);
+                    if (it != lookup.end())
+                        slot = it->second;
+                }
+                if (slot == fields.size())
+                {
+                    // 未声明的字段
+                    if (!skipValue(str, offset))
+                    {
+                        error = "invalid value for field '" + key + "'";
+                        return false;
+                    }
+                }
+                else
+                {
+                    if (seen[slot])
+                    {
+                        error = "duplicate field '" + key + "'";
+                        return false;
+                    }
+                    if (!parseValue(fields[slot], str, offset, record[slot], error))
+                        return false;
+                    seen[slot] = true;
+                    expected = slot + 1;
+                }
+                consumeWs(str, offset);
+                if (str[offset] == ',')
+                {
+                    ++offset;
+                    continue;
+                }
+                if (str[offset] != '}')
+                {
+                    error = "expected ',' or '}' in object";
+                    return false;
+                }
+                ++offset;
+                break;
+            }
+        for (size_t i = 0; i < fields.size(); ++i)
+            if (fields[i].required && !seen[i])
+            {
+                error = "missing required field '" + fields[i].key + "'";
+                return false;
+            }
+        return true;
+    }
+
+    // 按字段声明的类型解析值
+    bool schema::parseValue(const Field &f, const string &str, size_t &offset, json &value, string &error) const
+    {
+        const char *expected = "";
+        if (!f.required && str.compare(offset, 4, "null") == 0 && f.type != json::Class::Null)
+        {
+            offset += 4;
+            value = json();
+            return true;
+        }
+        switch (f.type)
+        {
+        case json::Class::String:
+        {
+            string val;
+            if (str[offset] == '\"' && parseStringRaw(str, offset, val))
+            {
+                value = std::move(val);
+                return true;
+            }
+            expected = "string";
+        }
+        break;
+        case json::Class::Integral:
+        case json::Class::Floating:
+        {
+            bool isDouble = false;
+            size_t end = scanNumber(str, offset, isDouble);
+            if (end == string::npos || (isDouble && f.type == json::Class::Integral))
+            {
+                expected = (f.type == json::Class::Integral) ? "integer" : "number";
+                break;
+            }
+            const char *begin = str.c_str() + offset;
+            if (f.type == json::Class::Floating)
+                value = std::strtod(begin, nullptr);
+            else
+            {
+                errno = 0;
+                long n = std::strtol(begin, nullptr, 10);
+                if (errno == ERANGE)
+                {
+                    error = "integer out of range in field '" + f.key + "'";
+                    return false;
+                }
+                value = n;
+            }
+            offset = end;
+            return true;
+        }
+        case json::Class::Boolean:
+            if (str.compare(offset, 4, "true") == 0)
+            {
+                offset += 4;
+                value = true;
+                return true;
+            }
+            if (str.compare(offset, 5, "false") == 0)
+            {
+                offset += 5;
+                value = false;
+                return true;
+            }
+            expected = "boolean";
+            break;
+        case json::Class::Null:
+            if (str.compare(offset, 4, "null") == 0)
+            {
+                offset += 4;
+                value = json();
+                return true;
+            }
+            expected = "null";
+            break;
+        case json::Class::Object:
+            if (f.nested)
+            {
+                vector<json> record(f.nested->fields.size());
+                if (!f.nested->parseObject(str, offset, record, error))
+                {
+                    error = "in field '" + f.key + "': " + error;
+                    return false;
+                }
+                value = f.nested->toObject(record);
+                return true;
+            }
+            // 没有嵌套声明的对象按普通json解析
+            if (str[offset] != '{')
+            {
+                expected = "object";
+                break;
+            }
+            if (!parseAny(str, offset, value))
+            {
+                error = "field '" + f.key + "': invalid object";
+                return false;
+            }
+            return true;
+        case json::Class::Array:
+            if (str[offset] != '[')
+            {
+                expected = "array";
+                break;
+            }
+            if (!parseAny(str, offset, value))
+            {
+                error = "field '" + f.key + "': invalid array";
+                return false;
+            }
+            return true;
+        }
+        error = "field '" + f.key + "': expected " + expected;
+        return false;
+    }
+
+    // 按RFC 8259的语法扫描数字，返回数字结束的位置，不合法返回npos
+    size_t schema::scanNumber(const string &str, size_t offset, bool &isDouble)
+    {
+        auto isDigit = [&](size_t i) { return str[i] >= '0' && str[i] <= '9'; };
+        if (str[offset] == '-')
+            ++offset;
+        if (str[offset] == '0')
+            ++offset;
+        else if (isDigit(offset))
+            while (isDigit(offset))
+                ++offset;
+        else
+            return string::npos;
+        if (str[offset] == '.')
+        {
+            isDouble = true;
+            if (!isDigit(++offset))
+                return string::npos;
+            while (isDigit(offset))
+                ++offset;
+        }
+        if (str[offset] == 'e' || str[offset] == 'E')
+        {
+            isDouble = true;
+            ++offset;
+            if (str[offset] == '+' || str[offset] == '-')
+                ++offset;
+            if (!isDigit(offset))
+                return string::npos;
+            while (isDigit(offset))
+                ++offset;
+        }
+        return offset;
+    }
+
+    // 解析任意json值，与parseNext不同的是遇到错误时返回false
+    bool schema::parseAny(const string &str, size_t &offset, json &value)
+    {
+        consumeWs(str, offset);
+        switch (str[offset])
+        {
+        case '{':
+        {
+            value = json::Make(json::Class::Object);
+            consumeWs(str, ++offset);
+            if (str[offset] == '}')
+            {
+                ++offset;
+                return true;
+            }
+            while (true)
+            {
+                string key;
+                consumeWs(str, offset);
+                if (str[offset] != '\"' || !parseStringRaw(str, offset, key))
+                    return false;
+                consumeWs(str, offset);
+                if (str[offset] != ':' || !parseAny(str, ++offset, value[key]))
+                    return false;
+                consumeWs(str, offset);
+                if (str[offset] == '}')
+                {
+                    ++offset;
+                    return true;
+                }
+                if (str[offset++] != ',')
+                    return false;
+            }
+        }
+        case '[':
+        {
+            value = json::Make(json::Class::Array);
+            consumeWs(str, ++offset);
+            if (str[offset] == ']')
+            {
+                ++offset;
+                return true;
+            }
+            for (unsigned index = 0;; ++index)
+            {
+                if (!parseAny(str, offset, value[index]))
+                    return false;
+                consumeWs(str, offset);
+                if (str[offset] == ']')
+                {
+                    ++offset;
+                    return true;
+                }
+                if (str[offset++] != ',')
+                    return false;
+            }
+        }
+        case '\"':
+        {
+            string val;
+            if (!parseStringRaw(str, offset, val))
+                return false;
+            value = std::move(val);
+            return true;
+        }
+        case 't':
+        case 'f':
+        case 'n':
+        {
+            const char *word = (str[offset] == 't') ? "true" : (str[offset] == 'f') ? "false" : "null";
+            size_t n = strlen(word);
+            if (str.compare(offset, n, word) != 0)
+                return false;
+            offset += n;
+            if (word[0] == 'n')
+                value = json();
+            else
+                value = (word[0] == 't');
+            return true;
+        }
+        default:
+        {
+            bool isDouble = false;
+            size_t end = scanNumber(str, offset, isDouble);
+            if (end == string::npos)
+                return false;
+            const char *begin = str.c_str() + offset;
+            errno = 0;
+            long n = isDouble ? 0 : std::strtol(begin, nullptr, 10);
+            // 超出long范围的整数按浮点数保存
+            if (isDouble || errno == ERANGE)
+                value = std::strtod(begin, nullptr);
+            else
+                value = n;
+            offset = end;
+            return true;
+        }
+        }
+    }
+
+    // 跳过一个值而不构造json对象，也不分配内存。
+    // 与parseAny的校验规则相同：对象的key必须是字符串，字符串检查转义和UTF-8。
+    bool schema::skipValue(const string &str, size_t &offset)
+    {
+        consumeWs(str, offset);
+        switch (str[offset])
+        {
+        case '{':
+            consumeWs(str, ++offset);
+            if (str[offset] == '}')
+            {
+                ++offset;
+                return true;
+            }
+            while (true)
+            {
+                consumeWs(str, offset);
+                if (str[offset] != '\"' || !readString(str, offset, nullptr))
+                    return false;
+                consumeWs(str, offset);
+                if (str[offset] != ':' || !skipValue(str, ++offset))
+                    return false;
+                consumeWs(str, offset);
+                if (str[offset] == '}')
+                {
+                    ++offset;
+                    return true;
+                }
+                if (str[offset++] != ',')
+                    return false;
+            }
+        case '[':
+            consumeWs(str, ++offset);
+            if (str[offset] == ']')
+            {
+                ++offset;
+                return true;
+            }
+            while (true)
+            {
+                if (!skipValue(str, offset))
+                    return false;
+                consumeWs(str, offset);
+                if (str[offset] == ']')
+                {
+                    ++offset;
+                    return true;
+                }
+                if (str[offset++] != ',')
+                    return false;
+            }
+        case '\"':
+            return readString(str, offset, nullptr);
+        case 't':
+        case 'n':
+            if (str.compare(offset, 4, str[offset] == 't' ? "true" : "null") != 0)
+                return false;
+            offset += 4;
+            return true;
+        case 'f':
+            if (str.compare(offset, 5, "false") != 0)
+                return false;
+            offset += 5;
+            return true;
+        default:
+        {
+            bool isDouble = false;
+            size_t end = scanNumber(str, offset, isDouble);
+            if (end == string::npos)
+                return false;
+            offset = end;
+            return true;
+        }
+        }
+    }
+
+    // JSON Patch（RFC 6902）和JSON Merge Patch（RFC 7396）
+    namespace
+    {
+        // 解析JSON Pointer（RFC 6901），"~1"还原为'/'，"~0"还原为'~'
+        bool parsePointer(const string &path, vector<string> &tokens)
+        {
+            tokens.clear();
+            if (path.empty())
+                return true;
+            if (path[0] != '/')
+                return false;
+            for (size_t i = 1;; ++i)
+            {
+                string token;
+                for (; i < path.size() && path[i] != '/'; ++i)
+                {
+                    if (path[i] != '~')
+                        token += path[i];
+                    else if (i + 1 < path.size() && (path[i + 1] == '0' || path[i + 1] == '1'))
+                        token += (path[++i] == '0') ? '~' : '/';
+                    else
+                        return false;
+                }
+                tokens.push_back(std::move(token));
+                if (i >= path.size())
+                    return true;
+            }
+        }
+        // 生成JSON Pointer的一段
+        string escapePointer(const string &token)
+        {
+            string res;
+            for (char c : token)
+            {
+                if (c == '~')
+                    res += "~0";
+                else if (c == '/')
+                    res += "~1";
+                else
+                    res += c;
+            }
+            return res;
+        }
+        // 解析数组下标，不允许前导0；"-"表示数组末尾（仅在allowEnd时有效）
+        bool parseIndex(const string &token, size_t size, bool allowEnd, unsigned &index)
+        {
+            if (token == "-")
+            {
+                index = static_cast<unsigned>(size);
+                return allowEnd;
+            }
+            if (token.empty() || token.size() > 9 || (token[0] == '0' && token.size() > 1))
+                return false;
+            index = 0;
+            for (char c : token)
+            {
+                if (c < '0' || c > '9')
+                    return false;
+                index = index * 10 + (c - '0');
+            }
+            return allowEnd ? index <= size : index < size;
+        }
+        // 按tokens[0, n)找到对应的节点，不存在返回nullptr
+        json *resolvePointer(json &doc, const vector<string> &tokens, size_t n)
+        {
+            json *cur = &doc;
+            for (size_t i = 0; i < n && cur; ++i)
+            {
+                unsigned index;
+                if (cur->jsonType() == json::Class::Object)
+                    cur = cur->find(tokens[i]);
+                else if (cur->jsonType() == json::Class::Array && parseIndex(tokens[i], cur->length(), false, index))
+                    cur = cur->find(index);
+                else
+                    cur = nullptr;
+            }
+            return cur;
+        }
+        // 在tokens处添加value，对象中的key必须不存在（替换由先删除再添加完成）
+        bool pointerAdd(json &doc, const vector<string> &tokens, json &value)
+        {
+            if (tokens.empty())
+            {
+                doc = std::move(value);
+                return true;
+            }
+            json *parent = resolvePointer(doc, tokens, tokens.size() - 1);
+            if (!parent)
+                return false;
+            if (parent->jsonType() == json::Class::Object)
+            {
+                if (parent->find(tokens.back()))
+                    return false;
+                (*parent)[tokens.back()] = std::move(value);
+                return true;
+            }
+            unsigned index;
+            if (parent->jsonType() != json::Class::Array || !parseIndex(tokens.back(), parent->length(), true, index))
+                return false;
+            parent->insert(index, std::move(value));
+            return true;
+        }
+        // 删除tokens处的节点，被删除的值移动到removed
+        bool pointerRemove(json &doc, const vector<string> &tokens, json &removed)
+        {
+            if (tokens.empty())
+            {
+                removed = std::move(doc);
+                doc = json();
+                return true;
+            }
+            json *parent = resolvePointer(doc, tokens, tokens.size() - 1);
+            if (!parent)
+                return false;
+            if (parent->jsonType() == json::Class::Object)
+            {
+                json *child = parent->find(tokens.back());
+                if (!child)
+                    return false;
+                removed = std::move(*child);
+                parent->erase(tokens.back());
+                return true;
+            }
+            unsigned index;
+            if (parent->jsonType() != json::Class::Array || !parseIndex(tokens.back(), parent->length(), false, index))
+                return false;
+            removed = std::move(*parent->find(index));
+            parent->erase(index);
+            return true;
+        }
+        // 补丁执行过程中的一步修改，失败时按相反顺序撤销。
+        // 删除的值保存在removed中；moved为true时值被移动到了下一步，撤销时从下一步取回。
+        struct PatchStep
+        {
+            vector<string> tokens;
+            bool added;
+            bool moved;
+            json removed;
+        };
+        // 生成一条patch操作
+        json patchOp(const char *op, const string &path)
+        {
+            json res = json::Make(json::Class::Object);
+            res["op"] = op;
+            res["path"] = path;
+            return res;
+        }
+        // 用Myers算法对齐a[begin, begin + n)和b[begin, begin + m)，
+        // 按顺序输出最长的相同元素序列的下标对。编辑距离超过maxEdits时放弃并返回false
+        bool alignArrays(const vector<json> &a, const vector<json> &b, size_t begin, size_t n, size_t m,
+                         vector<std::pair<size_t, size_t>> &matches)
+        {
+            const long maxEdits = 256;
+            long limit = std::min(static_cast<long>(n + m), maxEdits);
+            // v[k + limit]是对角线k上走得最远的x，trace[d]保存第d步结束时对角线[-d, d]的结果
+            vector<long> v(2 * limit + 3, 0);
+            vector<vector<long>> trace;
+            long x = 0, y = 0, d = 0;
+            bool found = false;
+            for (; d <= limit && !found; ++d)
+            {
+                for (long k = -d; k <= d; k += 2)
+                {
+                    if (k == -d || (k != d && v[k - 1 + limit] < v[k + 1 + limit]))
+                        x = v[k + 1 + limit];
+                    else
+                        x = v[k - 1 + limit] + 1;
+                    y = x - k;
+                    while (x < static_cast<long>(n) && y < static_cast<long>(m) && a[begin + x] == b[begin + y])
+                    {
+                        ++x;
+                        ++y;
+                    }
+                    v[k + limit] = x;
+                    if (x >= static_cast<long>(n) && y >= static_cast<long>(m))
+                    {
+                        found = true;
+                        break;
+                    }
+                }
+                trace.push_back(vector<long>(v.begin() + limit - d, v.begin() + limit + d + 1));
+            }
+            if (!found)
+                return false;
+            // 从终点往回走，记录对角线上的相同元素
+            x = static_cast<long>(n);
+            y = static_cast<long>(m);
+            for (d = static_cast<long>(trace.size()) - 1; d >= 0; --d)
+            {
+                long k = x - y, prevX = 0, prevY = 0;
+                if (d > 0)
+                {
+                    const vector<long> &prev = trace[d - 1];
+                    long prevK = (k == -d || (k != d && prev[k - 1 + d - 1] < prev[k + 1 + d - 1])) ? k + 1 : k - 1;
+                    prevX = prev[prevK + d - 1];
+                    prevY = prevX - prevK;
+                }
+                while (x > prevX && y > prevY)
+                {
+                    --x;
+                    --y;
+                    matches.push_back(std::make_pair(begin + x, begin + y));
+                }
+                x = prevX;
+                y = prevY;
+            }
+            std::reverse(matches.begin(), matches.end());
+            return true;
+        }
+        void diffInto(const json &from, const json &to, const string &path, json &patch)
+        {
+            if (from == to)
+                return;
+            if (from.jsonType() == json::Class::Object && to.jsonType() == json::Class::Object)
+            {
+                // 两个map都是有序的，同时遍历
+                auto &a = from.objectItems();
+                auto &b = to.objectItems();
+                auto i = a.begin(), j = b.begin();
+                while (i != a.end() || j != b.end())
+                {
+                    if (j == b.end() || (i != a.end() && i->first < j->first))
+                    {
+                        patch.append(patchOp("remove", path + "/" + escapePointer(i->first)));
+                        ++i;
+                    }
+                    else if (i == a.end() || j->first < i->first)
+                    {
+                        json op = patchOp("add", path + "/" + escapePointer(j->first));
+                        op["value"] = j->second;
+                        patch.append(std::move(op));
+                        ++j;
+                    }
+                    else
+                    {
+                        diffInto(i->second, j->second, path + "/" + escapePointer(i->first), patch);
+                        ++i;
+                        ++j;
+                    }
+                }
+                return;
+            }
+            if (from.jsonType() == json::Class::Array && to.jsonType() == json::Class::Array)
+            {
+                // 去掉相同的前缀和后缀，中间部分逐个比较，多余的删除或者补齐
+                auto &a = from.arrayItems();
+                auto &b = to.arrayItems();
+                size_t prefix = 0, suffix = 0;
+                while (prefix < a.size() && prefix < b.size() && a[prefix] == b[prefix])
+                    ++prefix;
+                while (suffix < a.size() - prefix && suffix < b.size() - prefix &&
+                       a[a.size() - 1 - suffix] == b[b.size() - 1 - suffix])
+                    ++suffix;
+                size_t lenA = a.size() - prefix - suffix, lenB = b.size() - prefix - suffix;
+                // 对齐中间部分，相同的元素保持不动；对齐失败时整段作为一个空隙
+                vector<std::pair<size_t, size_t>> matches;
+                if (!alignArrays(a, b, prefix, lenA, lenB, matches))
+                    matches.clear();
+                matches.push_back(std::make_pair(prefix + lenA, prefix + lenB));
+                // 逐个处理相邻两个对齐元素之间的空隙：位置对应的元素递归比较，多余的删除或者补齐。
+                // 空隙之前的部分已经和to相同，所以当前下标就是to中的下标
+                size_t i = prefix, j = prefix;
+                for (auto &match : matches)
+                {
+                    size_t gapA = match.first - i, gapB = match.second - j;
+                    size_t common = std::min(gapA, gapB);
+                    for (size_t n = 0; n < common; ++n)
+                        diffInto(a[i + n], b[j + n], path + "/" + std::to_string(j + n), patch);
+                    for (size_t n = common; n < gapA; ++n)
+                        patch.append(patchOp("remove", path + "/" + std::to_string(j + common)));
+                    for (size_t n = common; n < gapB; ++n)
+                    {
+                        json op = patchOp("add", path + "/" + std::to_string(j + n));
+                        op["value"] = b[j + n];
+                        patch.append(std::move(op));
+                    }
+                    i = match.first + 1;
+                    j = match.second + 1;
+                }
+                return;
+            }
+            json op = patchOp("replace", path);
+            op["value"] = to;
+            patch.append(std::move(op));
+        }
+    }
+
+    // 原地执行JSON Patch，只修改涉及到的节点。
+    // 任何一步失败时撤销已经执行的修改，doc保持原样并返回false。
+    bool applyPatch(json &doc, const json &patch, string *error = nullptr)
+    {
+        vector<PatchStep> steps;
+        string message;
+        // 删除tokens处的值，保存在撤销记录中
+        auto remove = [&](const vector<string> &tokens) {
+            json removed;
+            if (!pointerRemove(doc, tokens, removed))
+                return false;
+            steps.push_back(PatchStep{tokens, false, false, std::move(removed)});
+            return true;
+        };
+        // 把tokens处的值移出到value
+        auto take = [&](const vector<string> &tokens, json &value) {
+            if (!pointerRemove(doc, tokens, value))
+                return false;
+            steps.push_back(PatchStep{tokens, false, true, json()});
+            return true;
+        };
+        // 在tokens处添加value，已经存在的对象成员（或者根节点）先删除
+        auto add = [&](const vector<string> &tokens, json &value) {
+            json *parent = tokens.empty() ? nullptr : resolvePointer(doc, tokens, tokens.size() - 1);
+            if (tokens.empty() || (parent && parent->jsonType() == json::Class::Object && parent->find(tokens.back())))
+                remove(tokens);
+            // 撤销时需要具体的下标，"-"换成追加前数组的长度
+            vector<string> resolved = tokens;
+            if (parent && parent->jsonType() == json::Class::Array && tokens.back() == "-")
+                resolved.back() = std::to_string(parent->length());
+            if (!pointerAdd(doc, tokens, value))
+                return false;
+            steps.push_back(PatchStep{std::move(resolved), true, false, json()});
+            return true;
+        };
+        if (patch.jsonType() != json::Class::Array)
+            message = "patch must be an array";
+        const vector<json> &ops = patch.arrayItems();
+        for (size_t n = 0; message.empty() && n < ops.size(); ++n)
+        {
+            const json *name = ops[n].find("op");
+            const json *path = ops[n].find("path");
+            const json *from = ops[n].find("from");
+            const json *value = ops[n].find("value");
+            string kind = (name && name->jsonType() == json::Class::String) ? name->stringValue() : "";
+            string prefix = "operation " + std::to_string(n) + ": ";
+            vector<string> tokens, fromTokens;
+            if (!path || path->jsonType() != json::Class::String || !parsePointer(path->stringValue(), tokens))
+            {
+                message = prefix + "invalid path";
+                break;
+            }
+            if ((kind == "move" || kind == "copy") &&
+                (!from || from->jsonType() != json::Class::String || !parsePointer(from->stringValue(), fromTokens)))
+            {
+                message = prefix + "invalid from";
+                break;
+            }
+            if ((kind == "add" || kind == "replace" || kind == "test") && !value)
+            {
+                message = prefix + "missing value";
+                break;
+            }
+            json copied;
+            if (kind == "add")
+            {
+                copied = *value;
+                if (!add(tokens, copied))
+                    message = prefix + "cannot add at " + path->stringValue();
+            }
+            else if (kind == "remove")
+            {
+                if (tokens.empty() || !remove(tokens))
+                    message = prefix + "cannot remove " + path->stringValue();
+            }
+            else if (kind == "replace")
+            {
+                copied = *value;
+                if (!resolvePointer(doc, tokens, tokens.size()) || !remove(tokens) || !add(tokens, copied))
+                    message = prefix + "cannot replace " + path->stringValue();
+            }
+            else if (kind == "move")
+            {
+                // from不能是path的真前缀
+                if (fromTokens.size() < tokens.size() &&
+                    std::equal(fromTokens.begin(), fromTokens.end(), tokens.begin()))
+                    message = prefix + "cannot move a value into itself";
+                else if (!take(fromTokens, copied))
+                    message = prefix + "cannot move from " + from->stringValue();
+                else if (!add(tokens, copied))
+                {
+                    // 把值放回原处，撤销记录中不再需要这一步
+                    pointerAdd(doc, fromTokens, copied);
+                    steps.pop_back();
+                    message = prefix + "cannot move to " + path->stringValue();
+                }
+            }
+            else if (kind == "copy")
+            {
+                json *src = resolvePointer(doc, fromTokens, fromTokens.size());
+                if (src)
+                    copied = *src;
+                if (!src || !add(tokens, copied))
+                    message = prefix + "cannot copy to " + path->stringValue();
+            }
+            else if (kind == "test")
+            {
+                json *target = resolvePointer(doc, tokens, tokens.size());
+                if (!target || *target != *value)
+                    message = prefix + "test failed at " + path->stringValue();
+            }
+            else
+                message = prefix + "unknown op '" + kind + "'";
+        }
+        if (message.empty())
+        {
+            if (error)
+                error->clear();
+            return true;
+        }
+        // 撤销已经执行的修改
+        json carried;
+        for (auto it = steps.rbegin(); it != steps.rend(); ++it)
+        {
+            bool undone = it->added ? pointerRemove(doc, it->tokens, carried)
+                                    : pointerAdd(doc, it->tokens, it->moved ? carried : it->removed);
+            if (!undone)
+            {
+                message += " (rollback failed)";
+                break;
+            }
+        }
+        if (error)
+            *error = message;
+        return false;
+    }
+
+    // 原地执行JSON Merge Patch：值为null的key被删除，对象递归合并，其余直接替换
+    void mergePatch(json &doc, const json &patch)
+    {
+        if (patch.jsonType() != json::Class::Object)
+        {
+            doc = patch;
+            return;
+        }
+        if (doc.jsonType() != json::Class::Object)
+            doc = json::Make(json::Class::Object);
+        for (auto &p : patch.objectItems())
+        {
+            if (p.second.isNull())
+                doc.erase(p.first);
+            else
+                mergePatch(doc[p.first], p.second);
+        }
+    }
+
+    // 生成把from变成to的JSON Patch。
+    // 只对不同的子树生成操作。数组去掉相同的前后缀后用Myers算法对齐，
+    // 插入和删除不会导致后面的元素被整体替换；未对齐的元素按位置递归比较。
+    // 数组中间部分的编辑距离超过256时不再对齐，直接按位置比较，此时结果不保证最小。
+    json diff(const json &from, const json &to)
+    {
+        json patch = json::Make(json::Class::Array);
+        diffInto(from, to, "", patch);
+        return patch;
+    }
+
+#if __cplusplus >= 202002L
+    // 编译期解析嵌入的json字面量（需要C++20）。
+    // 用法：using namespace myJson::literals; constexpr auto cfg = R"({"port": 8080})"_json;
+    // 字面量在编译期校验，格式错误直接导致编译失败，结果是只读的静态文档。
+    namespace literal
+    {
+        // 可以作为模板参数的字符串
+        template <size_t N>
+        struct FixedString
+        {
+            char data[N] = {};
+            constexpr FixedString(const char (&s)[N])
+            {
+                for (size_t i = 0; i < N; ++i)
+                    data[i] = s[i];
+            }
+            constexpr size_t size() const { return N - 1; }
+        };
+
+        // 文档中的一个节点，按先序排列，子节点紧跟在父节点之后
+        struct Node
+        {
+            json::Class type = json::Class::Null;
+            // 字符串在text中的起始位置
+            size_t begin = 0;
+            // 字符串的长度，数组/对象的元素个数
+            size_t length = 0;
+            // 跳过当前子树后的下一个节点
+            size_t next = 0;
+            long Int = 0;
+            double Float = 0.0;
+            bool Bool = false;
+        };
+
+        // 节点数和解码后字符串的总长度
+        struct Sizes
+        {
+            size_t nodes;
+            size_t text;
+        };
+
+        // 定长的无符号大整数，只用于编译期浮点数的精确舍入
+        struct BigInt
+        {
+            // 5120位，足够容纳800位有效数字和10^1131
+            static constexpr size_t Capacity = 160;
+            unsigned limbs[Capacity] = {};
+            size_t size = 0;
+
+            // *this = *this * m + add
+            constexpr void mulAdd(unsigned m, unsigned add)
+            {
+                unsigned long long carry = add;
+                for (size_t i = 0; i < size; ++i)
+                {
+                    carry += static_cast<unsigned long long>(limbs[i]) * m;
+                    limbs[i] = static_cast<unsigned>(carry);
+                    carry >>= 32;
+                }
+                if (carry)
+                    limbs[size++] = static_cast<unsigned>(carry);
+            }
+            constexpr void shiftLeft(size_t bits)
+            {
+                if (size == 0)
+                    return;
+                size_t words = bits / 32, shift = bits % 32;
+                limbs[size + words] = 0;
+                for (size_t i = size; i-- > 0;)
+                {
+                    if (shift)
+                        limbs[i + words + 1] |= limbs[i] >> (32 - shift);
+                    limbs[i + words] = limbs[i] << shift;
+                }
+                for (size_t i = 0; i < words; ++i)
+                    limbs[i] = 0;
+                size += words + 1;
+                trim();
+            }
+            constexpr void shiftRight1()
+            {
+                for (size_t i = 0; i < size; ++i)
+                    limbs[i] = (limbs[i] >> 1) | (i + 1 < size ? limbs[i + 1] << 31 : 0);
+                trim();
+            }
+            // 要求*this >= other
+            constexpr void subtract(const BigInt &other)
+            {
+                long long borrow = 0;
+                for (size_t i = 0; i < size; ++i)
+                {
+                    long long cur = static_cast<long long>(limbs[i]) - (i < other.size ? other.limbs[i] : 0) - borrow;
+                    borrow = cur < 0;
+                    limbs[i] = static_cast<unsigned>(cur + (borrow << 32));
+                }
+                trim();
+            }
+            constexpr int compare(const BigInt &other) const
+            {
+                if (size != other.size)
+                    return size < other.size ? -1 : 1;
+                for (size_t i = size; i-- > 0;)
+                    if (limbs[i] != other.limbs[i])
+                        return limbs[i] < other.limbs[i] ? -1 : 1;
+                return 0;
+            }
+            constexpr size_t bitLength() const
+            {
+                if (size == 0)
+                    return 0;
+                size_t bits = 32 * (size - 1);
+                for (unsigned top = limbs[size - 1]; top; top >>= 1)
+                    ++bits;
+                return bits;
+            }
+            constexpr bool isZero() const { return size == 0; }
+            constexpr void trim()
+            {
+                while (size > 0 && limbs[size - 1] == 0)
+                    --size;
+            }
+        };
+
+        // 编译期解析器。nodes和text为nullptr时只统计所需空间
+        struct Parser
+        {
+            const char *s;
+            size_t len;
+            Node *nodes;
+            char *text;
+            size_t pos = 0;
+            size_t nodeCount = 0;
+            size_t textSize = 0;
+
+            constexpr Parser(const char *s, size_t len, Node *nodes = nullptr, char *text = nullptr)
+                : s(s), len(len), nodes(nodes), text(text)
+            {
+            }
+            // 在常量求值中抛出异常即为编译错误
+            constexpr void expect(bool ok, const char *what)
+            {
+                if (!ok)
+                    throw what;
+            }
+            constexpr char peek() const { return pos < len ? s[pos] : '\0'; }
+            static constexpr bool isDigit(char c) { return c >= '0' && c <= '9'; }
+            constexpr void consumeWs()
+            {
+                while (pos < len && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\n' || s[pos] == '\r'))
+                    ++pos;
+            }
+            constexpr size_t add(json::Class type)
+            {
+                if (nodes)
+                    nodes[nodeCount].type = type;
+                return nodeCount++;
+            }
+            constexpr void finish(size_t self)
+            {
+                if (nodes)
+                    nodes[self].next = nodeCount;
+            }
+            constexpr void put(char c)
+            {
+                if (text)
+                    text[textSize] = c;
+                ++textSize;
+            }
+            constexpr Sizes run()
+            {
+                parseNext();
+                consumeWs();
+                expect(pos == len, "json literal: trailing characters");
+                return {nodeCount, textSize};
+            }
+            // 主状态机
+            constexpr void parseNext()
+            {
+                consumeWs();
+                char c = peek();
+                if (c == '{')
+                    parseObject();
+                else if (c == '[')
+                    parseArray();
+                else if (c == '\"')
+                    parseString();
+                else if (c == 't')
+                    parseWord("true", json::Class::Boolean, true);
+                else if (c == 'f')
+                    parseWord("false", json::Class::Boolean, false);
+                else if (c == 'n')
+                    parseWord("null", json::Class::Null, false);
+                else
+                {
+                    expect(c == '-' || isDigit(c), "json literal: unexpected character");
+                    parseNumber();
+                }
+            }
+            constexpr void parseObject()
+            {
+                size_t self = add(json::Class::Object);
+                size_t count = 0;
+                ++pos;
+                consumeWs();
+                if (peek() == '}')
+                    ++pos;
+                else
+                    while (true)
+                    {
+                        consumeWs();
+                        expect(peek() == '\"', "json literal: object key must be a string");
+                        parseString();
+                        consumeWs();
+                        expect(peek() == ':', "json literal: expected ':' in object");
+                        ++pos;
+                        parseNext();
+                        ++count;
+                        consumeWs();
+                        if (peek() == ',')
+                        {
+                            ++pos;
+                            continue;
+                        }
+                        expect(peek() == '}', "json literal: expected ',' or '}' in object");
+                        ++pos;
+                        break;
+                    }
+                if (nodes)
+                    nodes[self].length = count;
+                finish(self);
+            }
+            constexpr void parseArray()
+            {
+                size_t self = add(json::Class::Array);
+                size_t count = 0;
+                ++pos;
+                consumeWs();
+                if (peek() == ']')
+                    ++pos;
+                else
+                    while (true)
+                    {
+                        parseNext();
+                        ++count;
+                        consumeWs();
+                        if (peek() == ',')
+                        {
+                            ++pos;
+                            continue;
+                        }
+                        expect(peek() == ']', "json literal: expected ',' or ']' in array");
+                        ++pos;
+                        break;
+                    }
+                if (nodes)
+                    nodes[self].length = count;
+                finish(self);
+            }
+            constexpr unsigned parseHex4()
+            {
+                unsigned unit = 0;
+                for (unsigned i = 0; i < 4; ++i)
+                {
+                    char c = peek();
+                    unit <<= 4;
+                    if (isDigit(c))
+                        unit |= c - '0';
+                    else if (c >= 'a' && c <= 'f')
+                        unit |= c - 'a' + 10;
+                    else if (c >= 'A' && c <= 'F')
+                        unit |= c - 'A' + 10;
+                    else
+                        expect(false, "json literal: invalid \\u escape");
+                    ++pos;
+                }
+                return unit;
+            }
+            constexpr void parseString()
+            {
+                size_t self = add(json::Class::String);
+                size_t begin = textSize;
+                ++pos;
+                while (true)
+                {
+                    expect(pos < len, "json literal: unterminated string");
+                    char c = s[pos];
+                    if (c == '\"')
+                        break;
+                    expect(static_cast<unsigned char>(c) >= 0x20, "json literal: unescaped control character");
+                    if (c != '\\')
+                    {
+                        unsigned cp = 0;
+                        size_t n = utf8Decode(s + pos, len - pos, cp);
+                        expect(n != 0, "json literal: invalid UTF-8");
+                        for (size_t i = 0; i < n; ++i)
+                            put(s[pos++]);
+                        continue;
+                    }
+                    ++pos;
+                    switch (peek())
+                    {
+                    case '\"':
+                    case '\\':
+                    case '/':
+                        put(peek());
+                        break;
+                    case 'b':
+                        put('\b');
+                        break;
+                    case 'f':
+                        put('\f');
+                        break;
+                    case 'n':
+                        put('\n');
+                        break;
+                    case 'r':
+                        put('\r');
+                        break;
+                    case 't':
+                        put('\t');
+                        break;
+                    case 'u':
+                    {
+                        ++pos;
+                        unsigned cp = parseHex4();
+                        expect(cp < 0xDC00 || cp > 0xDFFF, "json literal: lone low surrogate");
+                        if (cp >= 0xD800 && cp <= 0xDBFF)
+                        {
+                            expect(peek() == '\\' && pos + 1 < len && s[pos + 1] == 'u',
+                                   "json literal: missing low surrogate");
+                            pos += 2;
+                            unsigned low = parseHex4();
+                            expect(low >= 0xDC00 && low <= 0xDFFF, "json literal: invalid low surrogate");
+                            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        char buf[4] = {};
+                        size_t n = utf8EncodeTo(cp, buf);
+                        for (size_t i = 0; i < n; ++i)
+                            put(buf[i]);
+                    }
+                        continue;
+                    default:
+                        expect(false, "json literal: invalid escape");
+                    }
+                    ++pos;
+                }
+                ++pos;
+                if (nodes)
+                {
+                    nodes[self].begin = begin;
+                    nodes[self].length = textSize - begin;
+                }
+                finish(self);
+            }
+            constexpr void parseWord(const char *word, json::Class type, bool b)
+            {
+                size_t self = add(type);
+                for (; *word; ++word, ++pos)
+                    expect(peek() == *word, "json literal: invalid literal");
+                if (nodes)
+                    nodes[self].Bool = b;
+                finish(self);
+            }
+            // 按RFC 8259的语法解析数字，浮点数按就近偶数舍入，与strtod的结果一致
+            constexpr void parseNumber()
+            {
+                size_t self = add(json::Class::Integral);
+                bool negative = false, isDouble = false;
+                if (peek() == '-')
+                {
+                    negative = true;
+                    ++pos;
+                }
+                expect(isDigit(peek()), "json literal: invalid number");
+                size_t intBegin = pos;
+                if (peek() == '0')
+                    ++pos;
+                else
+                    while (isDigit(peek()))
+                        ++pos;
+                size_t intEnd = pos, fracBegin = pos, fracEnd = pos;
+                if (peek() == '.')
+                {
+                    isDouble = true;
+                    fracBegin = ++pos;
+                    expect(isDigit(peek()), "json literal: invalid number");
+                    while (isDigit(peek()))
+                        ++pos;
+                    fracEnd = pos;
+                }
+                long exp10 = 0;
+                if (peek() == 'e' || peek() == 'E')
+                {
+                    isDouble = true;
+                    ++pos;
+                    bool negExp = false;
+                    if (peek() == '+' || peek() == '-')
+                        negExp = (s[pos++] == '-');
+                    expect(isDigit(peek()), "json literal: invalid number");
+                    while (isDigit(peek()))
+                    {
+                        if (exp10 < 100000)
+                            exp10 = exp10 * 10 + (s[pos] - '0');
+                        ++pos;
+                    }
+                    if (negExp)
+                        exp10 = -exp10;
+                }
+                if (!isDouble)
+                {
+                    const unsigned long long limit =
+                        static_cast<unsigned long long>(std::numeric_limits<long>::max()) + (negative ? 1 : 0);
+                    unsigned long long mantissa = 0;
+                    for (size_t i = intBegin; i < intEnd; ++i)
+                    {
+                        expect(mantissa <= (limit - (s[i] - '0')) / 10, "json literal: integer out of range");
+                        mantissa = mantissa * 10 + (s[i] - '0');
+                    }
+                    if (nodes)
+                        nodes[self].Int = negative ? -static_cast<long>(mantissa - 1) - 1 : static_cast<long>(mantissa);
+                    finish(self);
+                    return;
+                }
+                double d = toDouble(intBegin, intEnd, fracBegin, fracEnd, exp10);
+                if (nodes)
+                {
+                    nodes[self].type = json::Class::Floating;
+                    nodes[self].Float = negative ? -d : d;
+                }
+                finish(self);
+            }
+            // 把十进制数字串[intBegin, intEnd) . [fracBegin, fracEnd) e exp10 转换成最接近的double。
+            // 有效数字的值不超过2^53且|指数|<=22时，一次乘除法就是正确舍入的；
+            // 其余情况用大整数算出商的前57位和余数，再按就近偶数舍入。
+            constexpr double toDouble(size_t intBegin, size_t intEnd, size_t fracBegin, size_t fracEnd, long exp10)
+            {
+                // 整数部分和小数部分拼成一个数字串，去掉首尾的0
+                size_t intLen = intEnd - intBegin, count = intLen + (fracEnd - fracBegin);
+                auto at = [&](size_t i) { return i < intLen ? s[intBegin + i] : s[fracBegin + i - intLen]; };
+                exp10 -= static_cast<long>(fracEnd - fracBegin);
+                size_t first = 0;
+                while (first < count && at(first) == '0')
+                    ++first;
+                while (count > first && at(count - 1) == '0')
+                {
+                    --count;
+                    ++exp10;
+                }
+                if (first == count)
+                    return 0.0;
+                // 超过800位的有效数字不影响舍入，截断后用末尾的1代表被截掉的非零部分
+                const size_t maxDigits = 800;
+                bool dropped = false;
+                if (count - first > maxDigits)
+                {
+                    exp10 += static_cast<long>(count - first - maxDigits);
+                    count = first + maxDigits;
+                    dropped = true;
+                }
+                long digits = static_cast<long>(count - first) + (dropped ? 1 : 0);
+                if (dropped)
+                    --exp10;
+                expect(digits + exp10 <= 310, "json literal: number out of range");
+                // 小于10^-330的数舍入为0
+                if (digits + exp10 < -330)
+                    return 0.0;
+                if (digits <= 19)
+                {
+                    unsigned long long mantissa = 0;
+                    for (size_t i = first; i < count; ++i)
+                        mantissa = mantissa * 10 + (at(i) - '0');
+                    if (mantissa <= (1ULL << 53) && exp10 >= -22 && exp10 <= 22)
+                    {
+                        double p = 1.0;
+                        for (long i = 0; i < (exp10 < 0 ? -exp10 : exp10); ++i)
+                            p *= 10.0;
+                        return exp10 < 0 ? static_cast<double>(mantissa) / p : static_cast<double>(mantissa) * p;
+                    }
+                }
+                // 值 = a / b
+                BigInt a, b;
+                for (size_t i = first; i < count; ++i)
+                    a.mulAdd(10, at(i) - '0');
+                if (dropped)
+                    a.mulAdd(10, 1);
+                b.mulAdd(1, 1);
+                for (long i = 0; i < (exp10 < 0 ? -exp10 : exp10); ++i)
+                    (exp10 < 0 ? b : a).mulAdd(10, 0);
+                // 缩放到a/b的商恰好有56或57位：值 = (a << k) / b * 2^-k
+                long k = 56 + static_cast<long>(b.bitLength()) - static_cast<long>(a.bitLength());
+                if (k >= 0)
+                    a.shiftLeft(static_cast<size_t>(k));
+                else
+                    b.shiftLeft(static_cast<size_t>(-k));
+                b.shiftLeft(56);
+                unsigned long long q = 0;
+                for (int i = 56; i >= 0; --i)
+                {
+                    if (a.compare(b) >= 0)
+                    {
+                        a.subtract(b);
+                        q |= 1ULL << i;
+                    }
+                    b.shiftRight1();
+                }
+                bool sticky = !a.isZero();
+                // 保留53位（非规格化数保留到2^-1074），按就近偶数舍入
+                int qBits = 0;
+                while (qBits < 64 && (q >> qBits) != 0)
+                    ++qBits;
+                long low = qBits - 1 - k - 52;
+                if (low < -1074)
+                    low = -1074;
+                long drop = low + k;
+                unsigned long long m = 0;
+                bool half = false, rest = sticky;
+                if (drop <= qBits)
+                {
+                    m = q >> drop;
+                    half = (q >> (drop - 1)) & 1;
+                    rest = rest || (q & ((1ULL << (drop - 1)) - 1)) != 0;
+                }
+                if (half && (rest || (m & 1)))
+                    ++m;
+                if (m == (1ULL << 53))
+                {
+                    m >>= 1;
+                    ++low;
+                }
+                unsigned long long bits = m;
+                if (m >= (1ULL << 52))
+                {
+                    long biased = low + 52 + 1023;
+                    expect(biased < 2047, "json literal: number out of range");
+                    bits = (static_cast<unsigned long long>(biased) << 52) | (m & ((1ULL << 52) - 1));
+                }
+                return std::bit_cast<double>(bits);
+            }
+        };
+
+        // 只读的节点视图，不存在的节点表现为null
+        class Value
+        {
+        public:
+            constexpr Value(const Node *nodes, const char *text, size_t index)
+                : nodes(nodes), text(text), index(index)
+            {
+            }
+            constexpr json::Class jsonType() const { return nodes ? nodes[index].type : json::Class::Null; }
+            constexpr bool isNull() const { return jsonType() == json::Class::Null; }
+            // 数组或对象的元素个数，其他类型返回-1
+            constexpr int size() const
+            {
+                return (jsonType() == json::Class::Array || jsonType() == json::Class::Object)
+                           ? static_cast<int>(nodes[index].length)
+                           : -1;
+            }
+            constexpr std::string_view toStringView() const
+            {
+                return jsonType() == json::Class::String
+                           ? std::string_view(text + nodes[index].begin, nodes[index].length)
+                           : std::string_view();
+            }
+            constexpr double toFloat() const { return jsonType() == json::Class::Floating ? nodes[index].Float : 0.0; }
+            constexpr long toInt() const { return jsonType() == json::Class::Integral ? nodes[index].Int : 0; }
+            constexpr bool toBool() const { return jsonType() == json::Class::Boolean ? nodes[index].Bool : false; }
+            // 根据key获取value，线性查找
+            constexpr Value operator[](std::string_view key) const
+            {
+                if (jsonType() != json::Class::Object)
+                    return Value(nullptr, nullptr, 0);
+                size_t child = index + 1;
+                for (size_t i = 0; i < nodes[index].length; ++i)
+                {
+                    if (Value(nodes, text, child).toStringView() == key)
+                        return Value(nodes, text, child + 1);
+                    child = nodes[child + 1].next;
+                }
+                return Value(nullptr, nullptr, 0);
+            }
+            // 根据index获取value，接受任意整数类型，负数视为越界
+            template <typename T, typename = typename enable_if<is_integral<T>::value>::type>
+            constexpr Value operator[](T i) const
+            {
+                if (jsonType() != json::Class::Array || i < 0 || static_cast<size_t>(i) >= nodes[index].length)
+                    return Value(nullptr, nullptr, 0);
+                size_t child = index + 1;
+                for (size_t n = static_cast<size_t>(i); n > 0; --n)
+                    child = nodes[child].next;
+                return Value(nodes, text, child);
+            }
+            // 转换成运行期可修改的json对象
+            json toJson() const
+            {
+                switch (jsonType())
+                {
+                case json::Class::Object:
+                {
+                    json res = json::Make(json::Class::Object);
+                    size_t child = index + 1;
+                    for (size_t i = 0; i < nodes[index].length; ++i)
+                    {
+                        res[string(Value(nodes, text, child).toStringView())] = Value(nodes, text, child + 1).toJson();
+                        child = nodes[child + 1].next;
+                    }
+                    return res;
+                }
+                case json::Class::Array:
+                {
+                    json res = json::Make(json::Class::Array);
+                    size_t child = index + 1;
+                    for (unsigned i = 0; i < nodes[index].length; ++i)
+                    {
+                        res[i] = Value(nodes, text, child).toJson();
+                        child = nodes[child].next;
+                    }
+                    return res;
+                }
+                case json::Class::String:
+                    return json(string(toStringView()));
+                case json::Class::Floating:
+                    return json(toFloat());
+                case json::Class::Integral:
+                    return json(toInt());
+                case json::Class::Boolean:
+                    return json(toBool());
+                default:
+                    return json();
+                }
+            }
+
+        private:
+            const Node *nodes;
+            const char *text;
+            size_t index;
+        };
+
+        // 编译期解析得到的文档，Nodes和TextSize由字面量的内容决定
+        template <size_t Nodes, size_t TextSize>
+        struct Document
+        {
+            Node nodes[Nodes] = {};
+            char text[TextSize == 0 ? 1 : TextSize] = {};
+
+            constexpr Value root() const { return Value(nodes, text, 0); }
+            constexpr json::Class jsonType() const { return root().jsonType(); }
+            constexpr Value operator[](std::string_view key) const { return root()[key]; }
+            template <typename T, typename = typename enable_if<is_integral<T>::value>::type>
+            constexpr Value operator[](T i) const { return root()[i]; }
+            json toJson() const { return root().toJson(); }
+        };
+    }
+
+    namespace literals
+    {
+        // json字面量，在编译期完成校验和解析
+        template <literal::FixedString S>
+        consteval auto operator""_json()
+        {
+            constexpr literal::Sizes sizes = literal::Parser(S.data, S.size()).run();
+            literal::Document<sizes.nodes, sizes.text> doc;
+            literal::Parser(S.data, S.size(), doc.nodes, doc.text).run();
+            return doc;
+        }
+    }
+#endif
+}
+
+// 使json可以直接作为unordered容器的键
+namespace std
+{
+    template <>
+    struct hash<myJson::json>
+    {
+        size_t operator()(const myJson::json &j) const { return static_cast<size_t>(j.hash()); }
+    };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,28 @@
+#include "../json.h"
+#include <iostream>
+#include <unordered_set>
+using namespace std;
+
+using myJson::json;
+
+int main()
+{
+    json a = json::Load("{\"b\":[1,2.5,\"x\"],\"a\":{\"z\":null,\"y\":true}}");
+    json b = json::Load("{\"a\":{\"y\":true,\"z\":null},\"b\":[1,2.5,\"x\"]}");
+    json c = json::Load("{\"a\":{\"y\":true,\"z\":null},\"b\":[1,2.5,\"y\"]}");
+    // 相等测试
+    cout << (a == b) << " " << (a == c) << " " << (json(2) == json(2.0)) << " " << (json(2) == json(2.5)) << endl;
+    // 哈希测试
+    cout << (a.hash() == b.hash()) << " " << (a.hash() == c.hash()) << " " << (json(3).hash() == json(3.0).hash()) << endl;
+    cout << json::Load("[1,\"a\",null]").hash() << endl;
+    // 规范化输出测试
+    cout << a.canonical() << endl;
+    cout << json::Load("[1.0,0.1,-0.0,100000000000000000000000.0,0.000001,0.0000001,123.456]").canonical() << endl;
+    cout << myJson::Array(1e21, 1e-7, 5e-324, 1.7976931348623157e308, 1.0 / 3).canonical() << endl;
+    cout << json("line\n\x01\xc3\xa9").canonical() << endl;
+    // 作为unordered容器的键
+    unordered_set<json> seen;
+    seen.insert(a);
+    cout << seen.count(b) << " " << seen.count(c) << endl;
+    return 0;
+}
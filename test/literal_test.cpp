@@ -0,0 +1,53 @@
+// 需要使用C++20编译
+#include "../json.h"
+#include <iostream>
+using namespace std;
+
+using myJson::json;
+using namespace myJson::literals;
+
+// 编译期解析，结果放在只读数据段中
+static constexpr auto config = R"({
+    "name": "tinyé",
+    "port": 8080,
+    "ratio": 0.25,
+    "big": -1.5e300,
+    "debug": false,
+    "tags": ["a", "b", {"nested": null}]
+})"_json;
+
+static_assert(config["port"].toInt() == 8080);
+static_assert(config["ratio"].toFloat() == 0.25);
+static_assert(config["tags"].size() == 3);
+static_assert(config["tags"][1].toStringView() == "b");
+static_assert(config["tags"][1u].toStringView() == "b");
+static_assert(config["tags"][size_t(2)]["nested"].isNull());
+static_assert(config["tags"][-1].isNull());
+static_assert(config["tags"][2]["nested"].isNull());
+static_assert(config["missing"].isNull());
+static_assert(config["name"].toStringView() == "tiny\xc3\xa9");
+
+// 浮点数与strtod一样按就近偶数舍入
+static constexpr auto floats = R"([9007199254740993.0, 1e300, 1.7976931348623157e308, 5e-324,
+    2.2250738585072011e-308, 0.1, 1e23, 2.4703282292062328e-324, 1e-400,
+    123456789012345678901234567890e-10])"_json;
+static_assert(floats[0].toFloat() == 9007199254740992.0);
+static_assert(floats[1].toFloat() == 1e300);
+static_assert(floats[2].toFloat() == 1.7976931348623157e308);
+static_assert(floats[3].toFloat() == 5e-324);
+static_assert(floats[4].toFloat() == 2.2250738585072011e-308);
+static_assert(floats[5].toFloat() == 0.1);
+static_assert(floats[6].toFloat() == 1e23);
+static_assert(floats[7].toFloat() == 5e-324);
+static_assert(floats[8].toFloat() == 0.0);
+static_assert(floats[9].toFloat() == 12345678901234567890.1234567890);
+
+int main()
+{
+    cout << config.toJson() << endl;
+    cout << config["big"].toFloat() << endl;
+    cout << ("[1, 2, 3]"_json).toJson() << endl;
+    // 以下字面量无法通过编译：
+    // auto bad = R"({"key": })"_json;
+    return 0;
+}
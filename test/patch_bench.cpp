@@ -0,0 +1,45 @@
+// 比较在大文档上做少量修改时，执行patch/生成diff与重新解析整个文档的耗时
+#include "../json.h"
+#include <chrono>
+#include <iostream>
+using namespace std;
+
+using myJson::json;
+
+template <typename F>
+double timeIt(int rounds, F f)
+{
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < rounds; ++i)
+        f();
+    return chrono::duration<double, micro>(chrono::steady_clock::now() - start).count() / rounds;
+}
+
+int main()
+{
+    const int records = 20000, rounds = 20;
+    json doc = json::Make(json::Class::Array);
+    for (int i = 0; i < records; ++i)
+        doc.append(json({"id", i, "name", "user" + to_string(i), "active", true,
+                         "tags", myJson::Array("a", "b", "c")}));
+    json changed = doc;
+    changed[100u]["name"] = "renamed";
+    changed[5000u]["active"] = false;
+    changed[19999u]["tags"].append("d");
+    string text = changed.dump();
+    json patch = myJson::diff(doc, changed);
+    cout << "document: " << text.size() << " bytes, patch: " << patch.dump().size() << " bytes" << endl;
+
+    double reparse = timeIt(rounds, [&] { json::Load(text); });
+    json target = doc;
+    json undo = myJson::diff(changed, doc);
+    double apply = timeIt(rounds, [&] {
+        myJson::applyPatch(target, patch);
+        myJson::applyPatch(target, undo);
+    }) / 2;
+    double diffCost = timeIt(rounds, [&] { myJson::diff(doc, changed); });
+    cout << "full reparse: " << reparse << " us" << endl;
+    cout << "apply patch:  " << apply << " us" << endl;
+    cout << "diff:         " << diffCost << " us" << endl;
+    return 0;
+}
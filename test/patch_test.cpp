@@ -0,0 +1,57 @@
+#include "../json.h"
+#include <iostream>
+using namespace std;
+
+using myJson::json;
+
+int main()
+{
+    string error;
+    json doc = json::Load("{\"a\":{\"b\":[1,2,3]},\"c\":\"x\",\"d/e\":true}");
+    json patch = json::Load("["
+                            "{\"op\":\"add\",\"path\":\"/a/b/1\",\"value\":9},"
+                            "{\"op\":\"remove\",\"path\":\"/c\"},"
+                            "{\"op\":\"replace\",\"path\":\"/d~1e\",\"value\":false},"
+                            "{\"op\":\"move\",\"from\":\"/a/b/0\",\"path\":\"/first\"},"
+                            "{\"op\":\"copy\",\"from\":\"/a\",\"path\":\"/copy\"},"
+                            "{\"op\":\"add\",\"path\":\"/a/b/-\",\"value\":\"end\"},"
+                            "{\"op\":\"test\",\"path\":\"/first\",\"value\":1}]");
+    // JSON Patch测试
+    if (myJson::applyPatch(doc, patch, &error))
+        cout << doc.canonical() << endl;
+    // 失败时整体撤销
+    json before = doc;
+    json bad = json::Load("[{\"op\":\"remove\",\"path\":\"/a\"},{\"op\":\"move\",\"from\":\"/first\",\"path\":\"/x/y\"}]");
+    if (!myJson::applyPatch(doc, bad, &error))
+        cout << "Error: " << error << " " << (doc == before) << endl;
+    bad = json::Load("[{\"op\":\"replace\",\"path\":\"\",\"value\":1},{\"op\":\"test\",\"path\":\"\",\"value\":2}]");
+    if (!myJson::applyPatch(doc, bad, &error))
+        cout << "Error: " << error << " " << (doc == before) << endl;
+    // 用"-"追加以及move之后失败，同样整体撤销
+    json arr = json::Load("{\"a\":[1,2],\"b\":1}");
+    before = arr;
+    bad = json::Load("[{\"op\":\"add\",\"path\":\"/a/-\",\"value\":3},{\"op\":\"test\",\"path\":\"/b\",\"value\":2}]");
+    if (!myJson::applyPatch(arr, bad, &error))
+        cout << "Error: " << error << " " << (arr == before) << endl;
+    bad = json::Load("[{\"op\":\"move\",\"from\":\"/b\",\"path\":\"/a/-\"},{\"op\":\"test\",\"path\":\"/zz\",\"value\":2}]");
+    if (!myJson::applyPatch(arr, bad, &error))
+        cout << "Error: " << error << " " << arr.canonical() << endl;
+    // JSON Merge Patch测试
+    json target = json::Load("{\"a\":\"b\",\"c\":{\"d\":\"e\",\"f\":\"g\"}}");
+    myJson::mergePatch(target, json::Load("{\"a\":\"z\",\"c\":{\"f\":null},\"n\":[1]}"));
+    cout << target.canonical() << endl;
+    // diff测试
+    json from = json::Load("{\"list\":[1,2,3,4,5],\"obj\":{\"k\":1,\"gone\":true},\"same\":\"s\"}");
+    json to = json::Load("{\"list\":[1,2,7,3,4,5],\"obj\":{\"k\":2,\"new\":null},\"same\":\"s\"}");
+    json delta = myJson::diff(from, to);
+    cout << delta.canonical() << endl;
+    myJson::applyPatch(from, delta, &error);
+    cout << (from == to) << endl;
+    // 整体平移的数组只产生一次删除和一次添加
+    json shifted = json::Load("[1,2,3]");
+    delta = myJson::diff(shifted, json::Load("[2,3,4]"));
+    cout << delta.canonical() << endl;
+    myJson::applyPatch(shifted, delta, &error);
+    cout << (shifted == json::Load("[2,3,4]")) << endl;
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include "../json.h"
+#include <iostream>
+using namespace std;
+
+using myJson::json;
+using myJson::schema;
+
+int main()
+{
+    schema user;
+    user.field("id", json::Class::Integral).field("name", json::Class::String, false);
+    schema event;
+    event.field("type", json::Class::String)
+        .field("ts", json::Class::Integral)
+        .field("value", json::Class::Floating)
+        .field("ok", json::Class::Boolean, false)
+        .field("user", user);
+    string error;
+    json out;
+    // 按声明顺序
+    if (event.parse("{\"type\":\"click\",\"ts\":1700000000,\"value\":1.5,\"ok\":true,\"user\":{\"id\":7,\"name\":\"bob\"}}", out, &error))
+        cout << out << endl;
+    // 乱序并且带有未声明的字段
+    if (event.parse("{\"user\":{\"id\":8},\"extra\":[1,{\"a\":\"}\"}],\"value\":2,\"ts\":1,\"type\":\"view\"}", out, &error))
+        cout << out << endl;
+    // 平坦记录
+    vector<json> record;
+    if (event.parse("{\"type\":\"buy\",\"ts\":2,\"value\":0.5,\"ok\":null,\"user\":{\"id\":9}}", record, &error))
+        cout << record[event.index("type")] << " " << record[event.index("ts")] << " " << record[event.index("ok")] << endl;
+    // 不符合schema
+    if (!event.parse("{\"type\":\"buy\",\"ts\":2.5,\"value\":0.5,\"user\":{\"id\":9}}", out, &error))
+        cout << "Error: " << error << endl;
+    if (!event.parse("{\"type\":\"buy\",\"ts\":2,\"value\":0.5}", out, &error))
+        cout << "Error: " << error << endl;
+    if (!event.parse("{\"type\":\"buy\",\"ts\":2,\"value\":0.5,\"user\":{\"name\":\"x\"}}", out, &error))
+        cout << "Error: " << error << endl;
+    // 没有嵌套声明的对象字段同样检查格式
+    schema loose;
+    loose.field("meta", json::Class::Object).field("id", json::Class::Integral);
+    if (loose.parse("{\"meta\":{\"a\":[1,2.5e3,\"x\"]},\"id\":1}", out, &error))
+        cout << out.canonical() << endl;
+    if (!loose.parse("{\"meta\":{\"a\": },\"id\":1}", out, &error))
+        cout << "Error: " << error << endl;
+    // 未声明字段中的括号也必须匹配
+    if (!loose.parse("{\"x\":[1},\"meta\":{},\"id\":1}", out, &error))
+        cout << "Error: " << error << endl;
+    // 未声明字段的内容同样按json语法校验
+    schema idOnly;
+    idOnly.field("id", json::Class::Integral);
+    const char *malformed[] = {"{\"x\":[,,,],\"id\":1}", "{\"x\":{:},\"id\":1}", "{\"x\":[1 2],\"id\":1}",
+                               "{\"x\":{1:2},\"id\":1}", "{\"x\":\"\\q\",\"id\":1}", "{\"x\":\"\xc0\xaf\",\"id\":1}"};
+    for (const char *doc : malformed)
+        if (!idOnly.parse(doc, out, &error))
+            cout << "Error: " << error << endl;
+    if (idOnly.parse("{\"x\":{\"a\":[1,-2.5e3,\"\\u00e9\",true,null,{}]},\"id\":1}", out, &error))
+        cout << out.canonical() << endl;
+    // 成功后不保留上一次的错误信息
+    if (loose.parse("{\"meta\":{},\"id\":2}", out, &error))
+        cout << "error: \"" << error << "\"" << endl;
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include "../json.h"
+#include <iostream>
+using namespace std;
+
+using myJson::json;
+
+int main()
+{
+    // 普通转义测试
+    cout << json::Load("\"a\\\"b\\\\c\\r\\n\\t\"") << endl;
+    // \u转义解码测试
+    cout << json::Load("\"caf\\u00e9 \\u4e2d\\u6587\"") << endl;
+    // 代理对测试
+    cout << json::Load("\"\\ud83d\\ude00\"") << endl;
+    // 只输出ASCII测试
+    cout << json::Load("\"caf\\u00e9 \\u4e2d\\u6587 \\ud83d\\ude00\"").dump(1, "  ", true) << endl;
+    cout << json::Load("{\"\\u952e\":\"\\u503c\"}").dump(1, "  ", true) << endl;
+    // 控制字符转义测试
+    cout << json("\x01\x1f") << endl;
+    // 长字符串测试
+    cout << json::Load("\"The quick brown fox jumps over the lazy dog. \xe4\xb8\xad\xe6\x96\x87 tail\"") << endl;
+    // 非法UTF-8测试
+    cout << json::Load("\"bad \xc0\xaf byte\"") << endl;
+    // 较长的非ASCII字符串（按16字节一组校验）
+    cout << json::Load("\"\xe4\xb8\xad\xe6\x96\x87\xe4\xb8\xad\xe6\x96\x87\xe4\xb8\xad\xe6\x96\x87 \xf0\x9f\x98\x80 caf\xc3\xa9\"") << endl;
+    cout << json::Load("\"\xe4\xb8\xad\xe6\x96\x87\xe4\xb8\xad\xe6\x96\x87\xe4\xb8\xad\xed\xa0\x80 surrogate\"") << endl;
+    // 孤立的代理测试
+    cout << json::Load("\"\\udc00\"") << endl;
+    // 未转义的控制字符测试
+    cout << json::Load("\"line\nbreak\"") << endl;
+    return 0;
+}